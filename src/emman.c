@@ -147,3 +147,24 @@ chunk_free (void *ptr, size_t size)
   #endif
 }
 
+/* return the memory of all pages completely within the range to the system,
+ * they read as zero afterwards. returns 0 if this is not supported. */
+int
+chunk_discard (void *ptr, size_t size)
+{
+  #if USE_MMAP && defined (MADV_DONTNEED)
+    char *beg, *end;
+
+    BOOT_PAGESIZE;
+
+    beg = (char *)(((size_t)ptr + PAGESIZE - 1) & ~(size_t)(PAGESIZE - 1));
+    end = (char *)(((size_t)ptr + size) & ~(size_t)(PAGESIZE - 1));
+
+    if (beg < end)
+      madvise (beg, end - beg, MADV_DONTNEED);
+
+    return 1;
+  #else
+    return 0;
+  #endif
+}
@@ -12,6 +12,7 @@ size_t chunk_fit (size_t header, size_t element_size, size_t max_increase);
 void *chunk_alloc (size_t size, int populate);
 void *chunk_realloc (void *ptr, size_t old_size, size_t new_size);
 void chunk_free (void *ptr, size_t size);
+int chunk_discard (void *ptr, size_t size);
 
 #if __cplusplus
 }
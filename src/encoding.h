@@ -83,9 +83,32 @@ extern unicode_t rxvt_compose (unicode_t c1, unicode_t c2);
 #define FROM_UNICODE(cs,code) rxvt_codeset[cs].from_unicode (code)
 #define TO_UNICODE(cs,code)   rxvt_codeset[cs].to_unicode   (code)
 
+#if BUILTIN_WCWIDTH
+// see table/width.h
+extern const uint8_t unicode_width_page[0x110000 >> 8];
+extern const uint8_t unicode_width_block[][64];
+#endif
+
 struct unicode // namespace für arme
 {
   static bool is_space (unicode_t c);
+
+#if BUILTIN_WCWIDTH
+  // like wcwidth, but from our own tables, so it does not depend on the
+  // locale. no branches except for the range check, including for ascii.
+  static int width (unicode_t c)
+  {
+    if (c > 0x10ffff)
+      return -1;
+
+    uint8_t bits = unicode_width_block [unicode_width_page [c >> 8]][(c & 0xff) >> 2];
+
+    return ((bits >> ((c & 3) * 2)) & 3) - 1;
+  }
+#endif
+
+  // the number of columns a string occupies on the screen
+  static int width (const wchar_t *s, int len);
 };
 
 #endif
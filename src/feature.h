@@ -292,6 +292,14 @@
 # define LINUX_YIELD_HACK 0
 #endif
 
+/*
+ * Start the command with vfork instead of fork where the tty can be made
+ * the controlling terminal with TIOCSCTTY. The cost of fork grows with the
+ * size of the process, which can be large for urxvtd with many terminals
+ * or a perl interpreter, vfork does not copy anything.
+ */
+#define USE_VFORK 1
+
 /* DEFAULT RESOURCES VALUES */
 
 /*
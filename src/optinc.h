@@ -38,11 +38,15 @@
  def(hold)       // hold window open after exit
  def(override_redirect)
  def(urgentOnBell)
+ def(backingPixmap)
+ def(fontCache)
 #else
  nodef(insecure)
  nodef(hold)
  nodef(override_redirect)
  nodef(urgentOnBell)
+ nodef(backingPixmap)
+ nodef(fontCache)
 #endif
 #ifdef BUILTIN_GLYPHS
  def(skipBuiltinGlyphs) // do not use internal glyphs
@@ -64,8 +68,15 @@
  def(console)
 #if XFT
  def(buffered)
+ def(renderCoreFonts)
 #else
  nodef(buffered)
+ nodef(renderCoreFonts)
 #endif
  def(dockapp)
+#if ENABLE_XSHM
+ def(clientRendering)
+#else
+ nodef(clientRendering)
+#endif
 
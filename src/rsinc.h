@@ -57,6 +57,10 @@
 #endif
 #if XFT
   def (buffered)
+  def (renderCoreFonts)
+#endif
+#if ENABLE_XSHM
+  def (clientRendering)
 #endif
 #if ENABLE_FRILLS
   def (depth)
@@ -73,6 +77,8 @@
   def (cursorUnderline)
   def (urgentOnBell)
   def (refreshRate)
+  def (backingPixmap)
+  def (fontCache)
 #endif
 #if BUILTIN_GLYPHS
   def (skipBuiltinGlyphs)
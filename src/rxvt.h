@@ -82,6 +82,22 @@ typedef  int32_t tlen_t_; // specifically for use in the line_t structure
 # define HAVE_IMG 1
 #endif
 
+#if XFT && HAVE_XSHM
+# define ENABLE_XSHM 1
+#endif
+
+#if XFT && HAVE_PTHREAD
+# define ENABLE_FONT_LOOKUP 1
+#endif
+
+#if HAVE_IMG && HAVE_PIXBUF && HAVE_PTHREAD && ENABLE_PERL
+# define ENABLE_IMG_LOADER 1
+#endif
+
+#if ENABLE_FONT_LOOKUP || ENABLE_IMG_LOADER
+# define ENABLE_WORKER 1
+#endif
+
 #define ECB_NO_THREADS 1
 #include "ecb.h"
 
@@ -156,6 +172,7 @@ char *           rxvt_wcstombs                    (const wchar_t *str, int len =
 wchar_t *        rxvt_mbstowcs                    (const char *str, int len = -1);
 char *           rxvt_wcstoutf8                   (const wchar_t *str, int len = -1);
 wchar_t *        rxvt_utf8towcs                   (const char *str, int len = -1);
+wchar_t *        rxvt_wcsdup                      (const wchar_t *str, int len);
 
 const char *     rxvt_basename                    (const char *str) noexcept;
 void             rxvt_vlog                        (const char *fmt, va_list arg_ptr) noexcept;
@@ -665,9 +682,13 @@ typedef struct _mwmhints
 // speed hack, copy some member variable into a local variable of the same name
 #define dLocal(type,name)       type const name = this->name
 
+#if BUILTIN_WCWIDTH
+# define WCWIDTH(c)		unicode::width (c)
+#else
 // for speed reasons, we assume that all codepoints 32 to 126 are
 // single-width.
-#define WCWIDTH(c)		(IN_RANGE_INC (c, 0x20, 0x7e) ? 1 : wcwidth (c))
+# define WCWIDTH(c)		(IN_RANGE_INC (c, 0x20, 0x7e) ? 1 : wcwidth (c))
+#endif
 
 /* convert pixel dimensions to row/column values.  Everything as int32_t */
 #define Pixel2Col(x)            Pixel2Width((int32_t)(x))
@@ -715,6 +736,7 @@ typedef struct _mwmhints
 
 typedef callback<void (const char *)> log_callback;
 typedef callback<int (int)> getfd_callback;
+typedef callback<void (rxvt_term *, bool)> map_callback;
 
 /****************************************************************************/
 
@@ -1084,6 +1106,9 @@ struct rxvt_vars : TermWin_t
 
   line_t         *row_buf;      // all lines, scrollback + terminal, circular
   line_t         *drawn_buf;    // text on screen
+#if TEXT_BLINK
+  uint16_t       *drawn_blink;  // number of blinking cells in each drawn_buf row
+#endif
   line_t         *swap_buf;     // lines for swap buffer
   char           *tabs;         /* per location: 1 == tab-stop               */
   screen_t        screen;
@@ -1105,6 +1130,7 @@ struct rxvt_term : zero_initialized, rxvt_vars, rxvt_screen
 
   log_callback   *log_hook;             // log error messages through this hook, if != 0
   getfd_callback *getfd_hook;           // convert remote to local fd, if != 0
+  map_callback   *map_hook;             // report the first map (or destruction before it), if != 0
 #if ENABLE_PERL
   rxvt_perl_term  perl;
 #endif
@@ -1191,6 +1217,17 @@ struct rxvt_term : zero_initialized, rxvt_vars, rxvt_screen
   static struct termios def_tio;
   row_col_t       oldcursor;
 
+#if ENABLE_FRILLS
+  // backingPixmap: scr_refresh renders into this off-screen copy of the
+  // vt window, which is then copied to the window, so exposures never
+  // need to redraw any text.
+  rxvt_drawable  *backing;
+  int             backing_w,
+                  backing_h,
+                  backing_y0,           // damaged part of the backing pixmap
+                  backing_y1;           // that still needs copying to the window
+#endif
+
 #ifdef HAVE_IMG
   enum {
     BG_IS_TRANSPARENT    = 1 << 1,
@@ -1222,9 +1259,40 @@ struct rxvt_term : zero_initialized, rxvt_vars, rxvt_screen
   char           *locale;
   char            charsets[4];
   char           *v_buffer;           /* pointer to physical buffer */
+  unsigned int    v_bufofs;           /* start of area to write */
   unsigned int    v_buflen;           /* size of area to write */
+  char           *paste_held;         /* user input held back during a streamed paste */
+  unsigned int    paste_held_len;
+  bool            paste_streamed;     /* a paste is being sent in pieces */
   stringvec      *argv, *envv;        /* if != 0, will be freed at destroy time */
   char           **env;
+  const char    **command_argv;       /* the command to run, 0 for the shell */
+#if ENABLE_FRILLS
+  // how long the steps of creating this terminal took, in seconds
+  struct
+  {
+    ev_tstamp begin; // when init, or init_start of a prepared terminal, began
+    float init;      // resources, fonts, colours and windows
+    float spawn;     // pty setup and forking the command
+    float map;       // from begin until the window was first mapped
+    bool prepared;   // initialised in advance, before it was requested
+  } startup;
+
+  // running totals, reported by urxvtd's STATS request
+  struct
+  {
+    enum { samples = 128 };
+    uint64_t parsed;              // bytes read from the pty
+    uint64_t written;             // bytes sent to the pty
+    uint32_t refreshes;           // scr_refresh calls that drew something
+    float refresh_time[samples];  // the latest scr_refresh durations, by refreshes % samples
+  } stats;
+
+  // idle terminals can be hibernated by urxvtd, see rxvt_term::hibernate
+  ev_tstamp       last_active;        // last pty or X event
+  uint8_t        *hibernated;         // packed screen buffers while hibernating, or 0
+  size_t          hibernated_size;
+#endif
 
 #ifdef KEYSYM_RESOURCE
   keyboard_manager *keyboard;
@@ -1326,6 +1394,11 @@ struct rxvt_term : zero_initialized, rxvt_vars, rxvt_screen
     SET_R (this);
     set_environ (env);
     rxvt_set_locale (locale);
+
+    // fontsets are shared, so point them at the terminal using them now
+    for (int i = 0; i < 4; i++)
+      if (fontset[i])
+        fontset[i]->set_term (const_cast<rxvt_term *>(this));
   }
 
 #if USE_XIM
@@ -1389,17 +1462,18 @@ struct rxvt_term : zero_initialized, rxvt_vars, rxvt_screen
   void process_sgr_mode (unsigned int nargs, const int *arg);
   void set_cursor_style (int style);
   // init.C
-  void init (stringvec *argv, stringvec *envv);
+  void init (stringvec *argv, stringvec *envv, bool start = true);
   void init (int argc, const char *const *argv, const char *const *envv);
-  void init2 (int argc, const char *const *argv);
+  void init2 (int argc, const char *const *argv, bool start);
+  void init_start ();
   void init_vars ();
   const char **init_resources (int argc, const char *const *argv);
-  void init_env ();
+  void init_env (simplevec<char *> &envp, stringvec &vars);
   void set_locale (const char *locale);
   void init_xlocale ();
   void init_command (const char *const *argv);
   void run_command (const char *const *argv);
-  int run_child (const char *const *argv);
+  void run_child (const char *file, const char *const *argv, const sigset_t *mask);
   void color_aliases (int idx);
   void create_windows (int argc, const char *const *argv);
   void get_colors ();
@@ -1415,6 +1489,7 @@ struct rxvt_term : zero_initialized, rxvt_vars, rxvt_screen
   void resize_all_windows (unsigned int newwidth, unsigned int newheight, int ignoreparent);
   void window_calc (unsigned int newwidth, unsigned int newheight);
   bool set_fonts ();
+  void put_fontsets ();
   void set_string_property (Atom prop, const char *str, int len = -1);
   void set_mbstring_property (Atom prop, const char *str, int len = -1);
   void set_utf8_property (Atom prop, const char *str, int len = -1);
@@ -1466,6 +1541,10 @@ struct rxvt_term : zero_initialized, rxvt_vars, rxvt_screen
 
   // modifies first argument(!)
   void tt_paste (char *data, unsigned int len) noexcept;
+  bool tt_paste_begin (bool streamed = false) noexcept;
+  void tt_paste_chunk (char *data, unsigned int len) noexcept;
+  void tt_paste_end (bool bracketed) noexcept;
+  bool tt_paste_streamable () noexcept;
   void paste (char *data, unsigned int len) noexcept;
   void scr_alloc () noexcept;
   void scr_blank_line (line_t &l, unsigned int col, unsigned int width, rend_t efs) const noexcept;
@@ -1476,9 +1555,25 @@ struct rxvt_term : zero_initialized, rxvt_vars, rxvt_screen
   void copy_line (line_t &dst, line_t &src);
   void scr_reset ();
   void scr_release () noexcept;
+#if ENABLE_FRILLS
+  void hibernate () noexcept;
+  void wake () noexcept;
+
+  // there was input or an event, resume normal operation
+  void active () noexcept
+  {
+    last_active = ev::now ();
+
+    if (ecb_expect_false (hibernated))
+      wake ();
+  }
+#endif
   void scr_clear (bool really = false) noexcept;
   void scr_refresh () noexcept;
   bool scr_refresh_rend (rend_t mask, rend_t value) noexcept;
+#if TEXT_BLINK
+  void scr_count_blink (int row) noexcept;
+#endif
   void scr_erase_screen (int mode) noexcept;
 #if ENABLE_FRILLS
   void scr_erase_savelines () noexcept;
@@ -1488,6 +1583,36 @@ struct rxvt_term : zero_initialized, rxvt_vars, rxvt_screen
   void scr_touch (bool refresh) noexcept;
   void scr_expose (int x, int y, int width, int height, bool refresh) noexcept;
   void scr_recolor (bool refresh = true) noexcept;
+#if OFF_FOCUS_FADING
+  void scr_switch_colors (rxvt_color *colors) noexcept;
+#endif
+  void clear_area (Drawable d, int x, int y, int w, int h) noexcept;
+#if ENABLE_FRILLS
+  bool backing_update () noexcept;
+  void backing_release () noexcept;
+  bool backing_expose (int x, int y, int w, int h) noexcept;
+  size_t backing_size () const noexcept;
+
+  void backing_damage (int y, int h) noexcept
+  {
+    min_it (backing_y0, y);
+    max_it (backing_y1, y + h);
+  }
+#endif
+
+#if ENABLE_XSHM
+  void shm_update () noexcept;
+#endif
+
+  // the drawable the screen contents are rendered into
+  rxvt_drawable &scr_drawable () noexcept
+  {
+#if ENABLE_FRILLS
+    if (backing)
+      return *backing;
+#endif
+    return *drawable;
+  }
   void scr_remap_chars () noexcept;
   void scr_remap_chars (line_t &l) noexcept;
 
@@ -9,10 +9,18 @@
 
 #include "rxvtutil.h"
 
+// upper limit for the size of a single request
+#define BLOB_MAX (16 * 1024 * 1024)
+
 struct rxvt_connection
 {
   int fd;
 
+  // flags of a REQ request
+  enum {
+    REQ_REPORT_MAP = 1, // send MAP once the window has been mapped
+  };
+
   static char *unix_sockname ();
 
   void send (const char *data, int len);
@@ -21,6 +29,13 @@ struct rxvt_connection
 
   bool recv (auto_str &data, int *len = 0);
   bool recv (int &data);
+
+  // 32 bit length prefix, for data that may exceed 64k
+  void send_blob (const char *data, int len);
+  bool recv_blob (auto_str &data, int &len);
+
+  static void put_int (simplevec<char> &buf, int data);
+  static int get_int (const char *data);
 };
 
 #endif
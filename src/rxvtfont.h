@@ -13,6 +13,7 @@
 #include "rxvttoolkit.h"
 
 struct rxvt_term;
+struct rxvt_fontset;
 
 struct rxvt_fontprop
 {
@@ -45,14 +46,25 @@ struct rxvt_font
   virtual ~rxvt_font () { free (name); };
 
   virtual void clear () { };
+  // drop whatever can be recreated on demand, e.g. rendered glyphs
+  virtual void trim () { };
 
   void clear_rect (rxvt_drawable &d, int x, int y, int w, int h, int color) const;
 
   virtual rxvt_fontprop properties () = 0;
 
   virtual bool load (const rxvt_fontprop &morph, bool force_prop) = 0;
+#if ENABLE_FONT_LOOKUP
+  // start matching the font in the lookup thread, true while the match is pending
+  virtual bool match_async (rxvt_fontset *fs, const rxvt_fontprop &prop, bool force_prop) { return false; }
+#endif
   virtual bool has_char (uint32_t unicode, const rxvt_fontprop *prop, bool &careful) const = 0;
 
+#if ENABLE_FRILLS
+  // number of glyphs rendered and kept around, for statistics
+  virtual int cached_glyphs () const { return 0; }
+#endif
+
   virtual void draw (rxvt_drawable &d,
                      int x, int y,
                      const text_t *text, int len,
@@ -67,7 +79,7 @@ struct rxvt_font
 
 struct rxvt_fallback_font;
 
-struct rxvt_fontset
+struct rxvt_fontset : refcounted
 {
   char *fontdesc;
 
@@ -81,13 +93,22 @@ struct rxvt_fontset
   // index of first font in set
   enum { firstFont = 2 };
 
-  rxvt_fontset (rxvt_term *term);
+  rxvt_fontset (rxvt_term *term, const char *id = "");
   ~rxvt_fontset ();
 
+  // the terminal the fonts currently draw for, see rxvt_term::make_current
+  rxvt_term *get_term () const { return term; }
+  void set_term (rxvt_term *term);
+
   bool populate (const char *desc);
-  void set_prop (const rxvt_fontprop &prop, bool force_prop) { this->prop = prop; this->force_prop = force_prop; }
+  void set_prop (const rxvt_fontprop &prop, bool force_prop);
+  const rxvt_fontprop &get_prop () const { return prop; }
   int find_font_idx (uint32_t unicode);
   int find_font (const char *name) const;
+#if ENABLE_FRILLS
+  void cache_stats (int &fonts, int &pages, int &glyphs) const;
+  void trim ();
+#endif
   bool realize_font (int i);
 
   rxvt_font *operator [] (int id) const
@@ -116,6 +137,7 @@ private:
   bool force_prop;
   simplevec<rxvt_font *> fonts;
   const rxvt_fallback_font *fallback;
+  int fallback_base; // number of fonts before any fallback fonts
 
   // this once was a "typedef xxx pagemap[256]
   // but c++ arrays are not normal types, and cannot be
@@ -131,6 +153,31 @@ private:
   };
   vector<pagemap *> fmap;
 
+#if ENABLE_FRILLS
+  // fontCache: fmap, together with the fallback fonts it refers to,
+  // is saved to disk and restored by the next fontset with the same key.
+  uint64_t cache_key;
+  bool cache_dirty;
+
+  uint64_t calc_cache_key ();
+  bool cache_path (char *path, int len);
+  void load_cache ();
+  void save_cache ();
+  bool realize_cached_font (int i);
+#endif
+
+#if ENABLE_FONT_LOOKUP
+  // bitmap pages of the codepoints fontconfig was already asked about
+  vector<uint32_t *> searched;
+  // the codepoints still searched for in the lookup thread
+  vector<unicode_t> pending;
+
+  bool search_font (unicode_t unicode);
+  void search_done (unicode_t unicode, FcPattern *match);
+  void lookup_done ();
+  friend struct rxvt_font_lookup;
+#endif
+
   void clear ();
   rxvt_font *new_font (const char *name, codeset cs);
   void prepare_font (rxvt_font *font, codeset cs);
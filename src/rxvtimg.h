@@ -47,11 +47,17 @@ struct rxvt_img
     }
   };
 
+  // operations not yet applied to the pixmap, see realize ()
+  struct fused_ops;
+
   rxvt_display *d;
   Pixmap pm;
   pixref *ref; // shared refcnt
   int x, y, w, h, repeat;
   XRenderPictFormat *format;
+  fused_ops *fused;
+
+  static size_t bytes_saved; // intermediate pixmap memory avoided by fusing operations
 
   rxvt_img (rxvt_screen *screen, XRenderPictFormat *format, int x, int y, int width, int height, int repeat = RepeatNormal);
   rxvt_img (rxvt_display *display, XRenderPictFormat *format, int x, int y, int width, int height, int repeat = RepeatNormal);
@@ -68,6 +74,7 @@ struct rxvt_img
 
   Pixmap steal ()
   {
+    realize ();
     ref->ours = false;
     return pm;
   }
@@ -84,6 +91,7 @@ struct rxvt_img
     this->repeat = repeat;
   }
 
+  void realize (); // apply pending (fused) operations
   void unshare (); // prepare for write
   void fill (const rgba &c);
   void fill (const rgba &c, int x, int y, int w, int h);
@@ -118,6 +126,8 @@ struct rxvt_img
 #endif
 
   // copy
+  // transform, scale, rotate and tint are deferred, so chains of them
+  // get fused into a single composite when the pixels are needed
   rxvt_img *reify (); // make x, y 0, make real width/height
   rxvt_img *blur (int rh, int rv);
   rxvt_img *clone ();
@@ -143,9 +153,25 @@ struct rxvt_img
   void destroy ();
   rxvt_img *new_empty ();
   Picture picture ();
+  rxvt_img *fuse (bool geometry);
   rxvt_img *transform (const nv *matrix);
 };
 
+# if ENABLE_IMG_LOADER
+// an image file being decoded in the image loader thread
+struct rxvt_img_load
+{
+  rxvt_img_load (rxvt_term *term);
+  ~rxvt_img_load ();
+
+  rxvt_term *term;
+  void *cb_sv; // managed by perl
+
+  void start (const char *filename); // may finish immediately
+  void finish (rxvt_img *img); // img is 0 on errors
+};
+# endif
+
 #endif
 
 #endif
@@ -61,6 +61,9 @@ struct rxvt_perl_interp
   bool invoke (rxvt_term *term, int htype, ...);
   void line_update (rxvt_term *term);
   void selection_finish (rxvt_selection *sel, char *data, unsigned int len);
+#if ENABLE_IMG_LOADER
+  void img_load_finish (rxvt_img_load *req, rxvt_img *img);
+#endif
   void usage (rxvt_term *term, int type);
 
   enum
@@ -170,7 +170,20 @@ SvPTR (SV *sv, const char *klass)
 }
 
 #define newSVterm(term) SvREFCNT_inc ((SV *)(term)->perl.self)
-#define SvTERM(sv) (rxvt_term *)SvPTR ((sv), "urxvt::term")
+#define SvTERM(sv) SvTERM_ (sv)
+
+// extensions might look at the screen, so a hibernated terminal wakes up
+static rxvt_term *
+SvTERM_ (SV *sv)
+{
+  rxvt_term *term = (rxvt_term *)SvPTR (sv, "urxvt::term");
+
+#if ENABLE_FRILLS
+  term->wake ();
+#endif
+
+  return term;
+}
 
 /////////////////////////////////////////////////////////////////////////////
 
@@ -449,6 +462,9 @@ rxvt_perl_interp::init (rxvt_term *term)
       term->perl.self = (void *)newSVptr ((void *)term, "urxvt::term");
       hv_store ((HV *)SvRV ((SV *)term->perl.self), "_overlay", 8, newRV_noinc ((SV *)newAV ()), 0);
       hv_store ((HV *)SvRV ((SV *)term->perl.self), "_selection", 10, newRV_noinc ((SV *)newAV ()), 0);
+#if ENABLE_IMG_LOADER
+      hv_store ((HV *)SvRV ((SV *)term->perl.self), "_img_load", 9, newRV_noinc ((SV *)newAV ()), 0);
+#endif
     }
 }
 
@@ -562,6 +578,17 @@ rxvt_perl_interp::invoke (rxvt_term *term, int htype, ...)
           rxvt_selection *req = (rxvt_selection *)SvIV (*av_fetch (av, i, 0));
           delete req;
         }
+
+#if ENABLE_IMG_LOADER
+      av = (AV *)SvRV (*hv_fetch ((HV *)SvRV ((SV *)term->perl.self), "_img_load", 9, 0));
+
+      for (int i = AvFILL (av); i >= 0; i--)
+        {
+          rxvt_img_load *req = (rxvt_img_load *)SvIV (*av_fetch (av, i, 0));
+          SvREFCNT_dec ((SV *)req->cb_sv);
+          delete req;
+        }
+#endif
     }
 
   bool event_consumed;
@@ -796,6 +823,48 @@ rxvt_perl_interp::selection_finish (rxvt_selection *sel, char *data, unsigned in
   LEAVE;
 }
 
+#if ENABLE_IMG_LOADER
+void
+rxvt_perl_interp::img_load_finish (rxvt_img_load *req, rxvt_img *img)
+{
+  AV *av = (AV *)SvRV (*hv_fetch ((HV *)SvRV ((SV *)req->term->perl.self), "_img_load", 9, 0));
+  int i;
+
+  for (i = AvFILL (av); i >= 0; i--)
+    if (SvIV (*av_fetch (av, i, 1)) == (IV)req)
+      break;
+
+  for (; i < AvFILL (av); i++)
+    av_store (av, i, SvREFCNT_inc (*av_fetch (av, i + 1, 0)));
+
+  SvREFCNT_dec (av_pop (av));
+
+  SV *cb_sv = (SV *)req->cb_sv;
+  delete req;
+
+  localise_env set_environ (perl_environ);
+
+  ENTER;
+  SAVETMPS;
+
+  dSP;
+  SV *sv = sv_newmortal ();
+  if (img)
+    sv_setref_pv (sv, "urxvt::img", (void *)img);
+  XPUSHs (sv);
+  PUTBACK;
+  call_sv (cb_sv, G_VOID | G_DISCARD | G_EVAL);
+
+  if (SvTRUE (ERRSV))
+    rxvt_warn ("perl image load callback evaluation error: %s", SvPVbyte_nolen (ERRSV));
+
+  FREETMPS;
+  LEAVE;
+
+  SvREFCNT_dec (cb_sv);
+}
+#endif
+
 /////////////////////////////////////////////////////////////////////////////
 
 MODULE = urxvt             PACKAGE = urxvt
@@ -1315,6 +1384,17 @@ rxvt_term::_keysym_resources ()
         _keysym_resources (THIS);
         SPAGAIN;
 
+void
+rxvt_term::startup_times ()
+	PPCODE:
+#if ENABLE_FRILLS
+        EXTEND (SP, 4);
+        PUSHs (sv_2mortal (newSVnv (THIS->startup.init)));
+        PUSHs (sv_2mortal (newSVnv (THIS->startup.spawn)));
+        PUSHs (sv_2mortal (newSVnv (THIS->startup.map)));
+        PUSHs (sv_2mortal (newSViv (THIS->startup.prepared)));
+#endif
+
 int
 rxvt_term::grab_button (int button, U32 modifiers, Window window = THIS->vt)
 	CODE:
@@ -1413,14 +1493,7 @@ rxvt_term::strwidth (SV *str)
         wchar_t *wstr = sv2wcs (str);
 
 	rxvt_push_locale (THIS->locale);
-        RETVAL = 0;
-        for (wchar_t *wc = wstr; *wc; wc++)
-          {
-            int w = WCWIDTH (*wc);
-
-            if (w)
-              RETVAL += max (w, 1);
-          }
+        RETVAL = unicode::width (wstr, wcslen (wstr));
         rxvt_pop_locale ();
 
         free (wstr);
@@ -1613,6 +1686,17 @@ rxvt_term::vt ()
         OUTPUT:
         RETVAL
 
+UV
+rxvt_term::backing_size ()
+	CODE:
+#if ENABLE_FRILLS
+        RETVAL = THIS->backing_size ();
+#else
+        RETVAL = 0;
+#endif
+        OUTPUT:
+        RETVAL
+
 void
 rxvt_term::vt_emask_add (U32 emask)
 	CODE:
@@ -2091,6 +2175,7 @@ rxvt_term::selection (SV *newtext = 0, bool clipboard = false)
 
         if (newtext)
           {
+            rxvt_selection_incr::release (text);
             free (text);
 
             text = sv2wcs (newtext);
@@ -2388,6 +2473,19 @@ rxvt_term::new_img_from_root ()
 
 #if HAVE_PIXBUF
 
+#if ENABLE_IMG_LOADER
+
+void
+rxvt_term::new_img_from_file_async (octet_string filename, SV *cb)
+	CODE:
+        rxvt_img_load *req = new rxvt_img_load (THIS);
+        req->cb_sv = newSVsv (cb);
+        AV *av = (AV *)SvRV (*hv_fetch ((HV *)SvRV ((SV *)THIS->perl.self), "_img_load", 9, 0));
+        av_push (av, newSViv ((IV)req));
+        req->start (filename);
+
+#endif
+
 rxvt_img *
 rxvt_term::new_img_from_file (octet_string filename)
 	CODE:
@@ -2484,6 +2582,13 @@ MODULE = urxvt             PACKAGE = urxvt::img
 # rxvt_img *new (rxvt_screen *screen, XRenderPictFormat *format, int width, int height)
 # rxvt_img *rxvt_img (rxvt_screen *screen, XRenderPictFormat *format, int width, int height, Pixmap pixmap);
 
+UV
+bytes_saved ()
+	CODE:
+        RETVAL = rxvt_img::bytes_saved;
+	OUTPUT:
+        RETVAL
+
 void
 rxvt_img::geometry ()
 	PPCODE:
@@ -2514,6 +2619,7 @@ rxvt_img::x ()
 Pixmap
 rxvt_img::pm ()
 	CODE:
+        THIS->realize ();
         RETVAL = THIS->pm;
 	OUTPUT:
         RETVAL
@@ -2535,6 +2641,9 @@ rxvt_img::DESTROY ()
 void
 rxvt_img::add_alpha ()
 
+void
+rxvt_img::realize ()
+
 void
 rxvt_img::unshare ()
 
@@ -30,6 +30,14 @@
 # include <X11/Xft/Xft.h>
 #endif
 
+#if ENABLE_XSHM
+# include <X11/extensions/XShm.h>
+#endif
+
+#if ENABLE_WORKER
+# include <pthread.h>
+#endif
+
 #include "ev_cpp.h"
 
 #include "rxvtutil.h"
@@ -99,6 +107,8 @@ enum {
 
 struct rxvt_term;
 struct rxvt_display;
+struct rxvt_fontset;
+struct rxvt_fontprop;
 
 struct im_watcher;
 struct xevent_watcher;
@@ -154,6 +164,50 @@ struct refcache : vector<T *>
 
 struct rxvt_screen;
 
+#if ENABLE_XSHM
+// client-side copy of a window, shared with the server via MIT-SHM.
+// fonts that can rasterise glyphs themselves draw into it and then
+// present the changed rectangle, instead of sending render requests.
+// only 32 bit truecolour pixels are supported.
+struct rxvt_shm_image
+{
+  rxvt_screen *screen;
+  Drawable dst;
+  GC gc;
+  XImage *img;
+  XShmSegmentInfo shminfo;
+  bool attached;
+
+  // the server reads the segment asynchronously, so rectangles that were
+  // presented must not be drawn into before their ShmCompletion arrived.
+  enum { MAX_PENDING = 16 };
+  int completion; // event type of ShmCompletion
+  vector<XRectangle> pending; // presented, oldest first
+
+  static Bool is_completion (Display *dpy, XEvent *ev, XPointer arg);
+  void completed ();
+  void reap ();
+  bool busy (int x, int y, int w, int h);
+  void wait (int x, int y, int w, int h);
+
+  rxvt_shm_image () : img (0), attached (false) { }
+  ~rxvt_shm_image () { destroy (); }
+
+  bool create (rxvt_screen *screen, Drawable dst, int w, int h);
+  void destroy ();
+
+  uint32_t *row (int y)
+  {
+    return (uint32_t *)(img->data + y * img->bytes_per_line);
+  }
+
+  void fill (int x, int y, int w, int h, uint32_t pixel);
+  // blend pixel over the image, using the 8 bit coverage mask as alpha
+  void blend (int x, int y, int w, int h, const uint8_t *mask, int stride, uint32_t pixel);
+  void present (int x, int y, int w, int h);
+};
+#endif
+
 struct rxvt_drawable
 {
   rxvt_screen *screen;
@@ -165,10 +219,17 @@ struct rxvt_drawable
   operator XftDraw *();
 #endif
 
+#if ENABLE_XSHM
+  rxvt_shm_image *shm; // if set, client-side rendering target for drawable
+#endif
+
   rxvt_drawable (rxvt_screen *screen, Drawable drawable)
   : screen(screen),
 #if XFT
     xftdrawable(0),
+#endif
+#if ENABLE_XSHM
+    shm(0),
 #endif
     drawable(drawable)
   { }
@@ -180,6 +241,45 @@ struct rxvt_drawable
 
 /////////////////////////////////////////////////////////////////////////////
 
+#if ENABLE_WORKER
+/*
+ * A thread for slow jobs, such as matching fonts or decoding images.
+ * Xlib is not thread-safe, so a job only computes its result in the
+ * thread, and is handed back to the main thread to use it.
+ */
+struct rxvt_worker
+{
+  struct job
+  {
+    void *owner; // 0 once the owner is gone, see cancel
+
+    job (void *owner) : owner (owner) { }
+    virtual ~job () { }
+
+    virtual void run () = 0;  // in the thread, unless cancelled before
+    virtual void done () = 0; // in the main thread, unless cancelled
+  };
+
+  // protected by lock
+  vector<job *> todo, finished;
+  job *busy;
+
+  pthread_mutex_t lock;
+  pthread_cond_t wake;
+  bool running;
+
+  int pipe_fd[2];
+  ev::io pipe_ev;
+  void pipe_cb (ev::io &w, int revents);
+
+  rxvt_worker ();
+  static void *thread (void *arg);
+
+  bool submit (job *j); // takes ownership, false if there is no thread
+  void cancel (void *owner);
+};
+#endif
+
 #if USE_XIM
 struct rxvt_xim : refcounted
 {
@@ -223,11 +323,32 @@ enum
 {
   DISPLAY_HAS_RENDER      = 1 << 0,
   DISPLAY_HAS_RENDER_CONV = 1 << 1,
+  DISPLAY_HAS_SHM         = 1 << 2,
+};
+
+// lookups in a display's resource database for one program name,
+// valid as long as the database is unchanged
+struct rxvt_resource_table
+{
+  char *name;
+  vector<const char *> values; // x_resource results, indexed by option
+  vector<char *> keysyms;      // keysym resources as pattern, value pairs
+  bool have_keysyms;
+
+  ~rxvt_resource_table ();
 };
 
 struct rxvt_display : refcounted
 {
-  event_vec<xevent_watcher> xw;
+  // xevent watchers, hashed by window, so events are only
+  // matched against the watchers of windows in the same bucket
+  enum { XW_BUCKETS = 64 };
+  event_vec<xevent_watcher> xw[XW_BUCKETS];
+
+  static unsigned int xw_bucket (Window window)
+  {
+    return (window ^ (window >> 6)) & (XW_BUCKETS - 1);
+  }
 
   ev::prepare flush_ev; void flush_cb (ev::prepare &w, int revents);
   ev::io      x_ev    ; void x_cb     (ev::io      &w, int revents);
@@ -240,6 +361,19 @@ struct rxvt_display : refcounted
   void im_change_check ();
 #endif
 
+  // fontsets are shared by all terminals on the display using the
+  // same fonts with the same properties
+  vector<rxvt_fontset *> fontsets;
+
+  // the resource database is reused by further terminals until one
+  // of its sources changes
+  char *res_stamp;
+  bool res_dirty;
+  vector<rxvt_resource_table *> res_tables;
+
+  char *resource_stamp ();
+  void clear_resource_tables ();
+
 //public
   Display   *dpy;
   int       screen;
@@ -255,6 +389,9 @@ struct rxvt_display : refcounted
 
   rxvt_display (const char *id);
   XrmDatabase get_resources (bool refresh);
+  bool resources_changed (const XEvent &xev);
+  void resources_modified (); // a terminal merged its options into the database
+  rxvt_resource_table *get_resource_table (const char *name);
   bool ref_init ();
   void ref_next ();
   ~rxvt_display ();
@@ -268,6 +405,9 @@ struct rxvt_display : refcounted
   Pixmap get_pixmap_property (Atom property);
   void set_selection_owner (rxvt_term *owner, bool clipboard);
 
+  rxvt_fontset *get_fontset (rxvt_term *term, const char *desc, const rxvt_fontprop *prop = 0, bool force_prop = false);
+  void put_fontset (rxvt_term *term, rxvt_fontset *fs);
+
   void reg (xevent_watcher *w);
   void unreg (xevent_watcher *w);
 
@@ -298,6 +438,7 @@ struct im_watcher : rxvt_watcher, callback<void (void)>
 struct xevent_watcher : rxvt_watcher, callback<void (XEvent &)>
 {
   Window window;
+  unsigned int bucket; // where the display keeps us while active
 
   void start (rxvt_display *display, Window window)
   {
@@ -356,6 +497,12 @@ struct rxvt_color
   bool alloc (rxvt_screen *screen, const rgba &color);
   void free (rxvt_screen *screen);
 
+  // drop cached lookups and allocations of a display being closed
+  static void forget (Display *dpy);
+
+  // number of cached colour names and colormap allocations
+  static void cache_stats (int &names, int &allocs);
+
   operator rgba () const
   {
     rgba c;
@@ -384,6 +531,7 @@ struct rxvt_selection
 {
   rxvt_selection (rxvt_display *disp, int selnum, Time tm, Window win, Atom prop, rxvt_term *term);
   void run ();
+  void resume (); // the terminal has written some of its pty queue
   ~rxvt_selection ();
 
   rxvt_term *term; // terminal to paste to, may be 0
@@ -400,15 +548,58 @@ private:
 
   char *incr_buf;
   size_t incr_buf_size, incr_buf_fill;
+  bool incr_utf8;  // the INCR chunks are UTF8_STRING, not STRING
+  bool streaming;  // INCR chunks are pasted as they arrive
+  bool bracketed;  // the streamed paste was opened with a bracket
+  bool blocked;    // the next chunk waits for the pty queue to drain
 
   void timer_cb (ev::timer &w, int revents); ev::timer timer_ev;
   void x_cb (XEvent &xev); xevent_watcher x_ev;
 
   void finish (char *data = 0, unsigned int len = 0);
+  void paste_incr ();
   void stop ();
   bool request (Atom target, int selnum);
   void handle_selection (Window win, Atom prop, bool delete_prop);
 };
 
+// sends a selection too large for a single request using the INCR
+// protocol (ICCCM 2.7.2), converting it chunk by chunk as the requestor
+// deletes the property.
+struct rxvt_selection_incr
+{
+  // the number of characters that fit into a single property
+  static size_t chunk_len (Display *dpy, bool utf8);
+
+  // starts the transfer, text must stay valid until release is called
+  rxvt_selection_incr (rxvt_display *disp, Window requestor, Atom prop,
+                       int style, const wchar_t *text, size_t len);
+  ~rxvt_selection_incr ();
+
+  // text is about to be freed or changed, copy what is still to be sent
+  static void release (const wchar_t *text);
+  // the display is closing, abort all its transfers
+  static void cancel (rxvt_display *disp);
+
+private:
+  static vector<rxvt_selection_incr *> transfers;
+
+  rxvt_display *display;
+  Window requestor;
+  Atom prop;
+  int style; // -1 for utf-8, an XICCEncodingStyle otherwise
+  long orig_mask;
+
+  const wchar_t *text;
+  wchar_t *copy; // set if text had to be copied
+  size_t len, pos;
+  bool done;
+
+  void timer_cb (ev::timer &w, int revents); ev::timer timer_ev;
+  void x_cb (XEvent &xev); xevent_watcher x_ev;
+
+  void send_chunk ();
+};
+
 #endif
 
@@ -1489,6 +1489,14 @@ sub x_resource_boolean {
    $res =~ /^\s*(?:true|yes|on|1)\s*$/i ? 1 : defined $res && 0
 }
 
+=item ($init, $spawn, $map, $prepared) = $term->startup_times
+
+Returns the number of seconds it took to initialise the terminal, to
+start its command, and from the start of initialisation until the window
+got mapped (C<0> if that has not happened yet), and whether the
+terminal was prepared in advance by B<urxvtd>'s pool. Returns the empty
+list when rxvt-unicode was compiled without frills.
+
 =item $action = $term->lookup_keysym ($keysym, $state)
 
 Returns the action bound to key combination C<($keysym, $state)>,
@@ -1741,6 +1749,11 @@ Return the window id of the toplevel window.
 
 Return the window id of the terminal window.
 
+=item $bytes = $term->backing_size
+
+Returns the (approximate) amount of X server memory used by the
+B<backingPixmap>, or C<0> if no backing pixmap is in use.
+
 =item $term->vt_emask_add ($x_event_mask)
 
 Adds the specified events to the vt event mask. Useful e.g. when you want
@@ -2404,6 +2417,31 @@ Stop the watcher.
 
 =back
 
+=head2 The C<urxvt::img> Class
+
+This class wraps the images used by the F<background> extension. Only
+the methods concerned with deferred operations are described here.
+
+Transformations, scaling, rotation, tinting and shading do not render
+anything right away. Chains of them are remembered and fused into a
+single XRender composite, which is only done when the pixels are needed,
+e.g. when the image is drawn, its pixmap is requested or it is cropped.
+
+=over
+
+=item $img->realize
+
+Applies all pending operations now. This is never required for correct
+results, but can be used to do the work at a time of your choosing, for
+example before the image is cached and reused many times.
+
+=item $bytes = urxvt::img::bytes_saved
+
+Returns the total size, in bytes, of the intermediate pixmaps that were
+never created because operations were fused, since the program started.
+
+=back
+
 =head1 ENVIRONMENT
 
 =head2 URXVT_PERL_VERBOSITY